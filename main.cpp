@@ -7,6 +7,15 @@
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
 
 using namespace std;
 
@@ -17,18 +26,41 @@ struct HealthRecord {
     string actions;
 };
 
+// Monthly rollup of health records that were moved to plants.cold
+struct HealthSummary {
+    string month;  // YYYY-MM
+    string firstDate;
+    string lastDate;
+    map<string, int> conditionCounts;
+};
+
 struct Plant {
+    int id;  // in-memory key for the history cache, not saved to file
     string name;
     string species;
     string location;
     string wateringFrequency;
     string lastWatered;
-    vector<HealthRecord> healthHistory;
     string lastFertilized;
     string soilType;
     string potSize;
     bool needsRepotting;
     string nextWateringDate;
+
+    // Health history is kept on disk and faulted in through the history cache
+    streampos historyOffset;  // start of this plant's records in plants.txt, -1 if none saved
+    int historyCount;
+    bool historySpilled;  // records were evicted to plants.spill and are not in plants.txt yet
+
+    vector<HealthSummary> healthSummaries;
+    vector<streamoff> coldSegments;  // offsets of this plant's blocks in plants.cold
+};
+
+struct HistoryCacheEntry {
+    vector<HealthRecord> records;
+    size_t bytes;  // estimated memory used by records
+    bool dirty;
+    list<int>::iterator lruPosition;
 };
 
 const string RESET = "\033[0m";
@@ -63,6 +95,17 @@ const string SMALL_PLANT = R"(
 
 
 vector<Plant> plants;
+int nextPlantId = 1;
+
+// Cached health records are limited to about this many bytes (0 = no limit).
+// Plant details are always in memory and are not counted.
+size_t historyCacheLimit = 0;
+size_t historyCacheBytes = 0;
+unordered_map<int, HistoryCacheEntry> historyCache;
+list<int> historyLru;  // most recently used plant id at the front
+
+// Checkpoints are kept daily for this long, then only the last one of each month
+const int CHECKPOINT_DAILY_DAYS = 90;
 
 // Plant-related functions
 void addNewPlant();
@@ -77,26 +120,158 @@ void displayPlant(const Plant& plant);
 // File I/O functions
 void saveToFile();
 void loadFromFile();
+vector<Plant> readPlantFile(const string& path);
+void writePlantHeader(ostream& file, const Plant& plant);
+bool readLine(istream& in, string& line);
+long long parseStoredNumber(const string& text, const string& path);
+vector<HealthRecord> readHealthRecords(istream& in, const Plant& plant);
+void writeHealthRecords(ostream& file, const vector<HealthRecord>& records);
+streamoff fileSize(const string& path);
+HANDLE acquireDataLock();
+
+// History cache functions
+vector<HealthRecord>& getHealthHistory(Plant& plant);
+void markHistoryDirty(const Plant& plant);
+void dropHistory(int plantId);
+void trimHistoryCache(int keepId);
+size_t estimateHistoryBytes(const vector<HealthRecord>& records);
+void spillHistory(int plantId);
+int runBenchmark();
+
+// Compaction functions
+void compactHealthHistory(int retentionDays);
+void addToSummary(Plant& plant, const HealthRecord& record);
+string encodeColdBlock(const vector<HealthRecord>& records);
+vector<HealthRecord> readColdRecords(const Plant& plant);
+
+// Checkpoint functions
+void writeCheckpoint();
+void pruneCheckpoints();
+vector<string> listCheckpoints();
+string findCheckpoint(const string& date);
+bool printReportAsOf(const string& requestedDate);
 
 // Helper functions
 void returnToMainMenu();
 string getCurrentDate();
 string calculateNextWateringDate(const string& frequency, const string& lastWatered);
+string addDays(const string& date, int days);
+tm parseDate(const string& date);
+time_t dateToTime(const string& date);
+string normalizeDate(const string& date);
 void pauseProgram(int time);
 void mainMenu();
 void printBoxedText(const string& text, const string& color);
 void printDivider();
 void clearScreen();
+void printUsage();
+bool parseCount(const string& text, size_t& value);
+
+// Reminder mode
+int runReminders(const string& outputPath);
+bool getLastWriteTime(const string& path, FILETIME& writeTime);
+DWORD sendDueReminders(ostream& out, set<string>& notified);
 
-int main() {
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
+
+    bool reminderMode = false;
+    string reminderOutput;
+    bool compactMode = false;
+    size_t retentionDays = 0;
+    string asOfDate;
+    bool benchMode = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--cache-size" && i + 1 < argc) {
+            size_t kilobytes;
+            if (!parseCount(argv[++i], kilobytes)) {
+                printUsage();
+                return 1;
+            }
+            historyCacheLimit = kilobytes * 1024;
+        } else if (arg == "--remind") {
+            reminderMode = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            reminderOutput = argv[++i];
+        } else if (arg == "--compact" && i + 1 < argc) {
+            if (!parseCount(argv[++i], retentionDays)) {
+                printUsage();
+                return 1;
+            }
+            compactMode = true;
+        } else if (arg == "--as-of" && i + 1 < argc) {
+            asOfDate = argv[++i];
+        } else if (arg == "--bench") {
+            benchMode = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (!reminderOutput.empty() && !reminderMode) {
+        printUsage();
+        return 1;
+    }
+
+    if (!asOfDate.empty()) {
+        return printReportAsOf(asOfDate) ? 0 : 1;
+    }
+
+    if (benchMode) {
+        HANDLE lock = acquireDataLock();
+        if (lock == INVALID_HANDLE_VALUE) {
+            cerr << "Plant Care System is open. Close it before running the benchmark.\n";
+            return 1;
+        }
+        int status = 1;
+        try {
+            status = runBenchmark();
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << "\n";
+        }
+        CloseHandle(lock);
+        return status;
+    }
+
+    if (compactMode) {
+        HANDLE lock = acquireDataLock();
+        if (lock == INVALID_HANDLE_VALUE) {
+            cerr << "Plant Care System is open. Close it before compacting health records.\n";
+            return 1;
+        }
+        int status = 0;
+        try {
+            loadFromFile();
+            compactHealthHistory(retentionDays);
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << "\n";
+            status = 1;
+        }
+        CloseHandle(lock);
+        return status;
+    }
+
+    if (reminderMode) {
+        return runReminders(reminderOutput);
+    }
+
+    HANDLE lock = acquireDataLock();
+    if (lock == INVALID_HANDLE_VALUE) {
+        cout << "Plant Care System is already open or compacting its records.\n";
+        return 1;
+    }
+
     cout << "Welcome to Plant Care System!\n\n";
     mainMenu();
+    CloseHandle(lock);
     return 0;
 }
 
 void addNewPlant() {
     Plant newPlant;
+    newPlant.id = nextPlantId++;
 
     cout << "\n=== Add New Plant ===\n";
     cout << "Enter plant name: ";
@@ -121,6 +296,9 @@ void addNewPlant() {
     newPlant.nextWateringDate = calculateNextWateringDate(newPlant.wateringFrequency, newPlant.lastWatered);
     newPlant.lastFertilized = "Not yet fertilized";
     newPlant.needsRepotting = false;
+    newPlant.historyOffset = -1;
+    newPlant.historyCount = 0;
+    newPlant.historySpilled = false;
 
     plants.push_back(newPlant);
     saveToFile();
@@ -155,10 +333,11 @@ void viewPlantHistory() {
     displayPlant(plant);
 
     cout << "\nHealth History:\n";
-    if (plant.healthHistory.empty()) {
+    const vector<HealthRecord>& history = getHealthHistory(plant);
+    if (history.empty()) {
         cout << "No health records yet.\n";
     } else {
-        for (const HealthRecord& record : plant.healthHistory) {
+        for (const HealthRecord& record : history) {
             cout << "\nDate: " << record.date
                  << "\nCondition: " << record.condition
                  << "\nSymptoms: " << record.symptoms
@@ -167,6 +346,31 @@ void viewPlantHistory() {
         }
     }
 
+    if (!plant.healthSummaries.empty()) {
+        cout << "\nArchived History:\n";
+        for (const HealthSummary& summary : plant.healthSummaries) {
+            cout << summary.month << " (" << summary.firstDate << " to " << summary.lastDate << "):";
+            for (const auto& count : summary.conditionCounts) {
+                cout << " " << count.first << " x" << count.second;
+            }
+            cout << endl;
+        }
+
+        cout << "\nShow archived records? (y/n): ";
+        char show;
+        cin >> show;
+        cin.ignore();
+        if (show == 'y' || show == 'Y') {
+            for (const HealthRecord& record : readColdRecords(plant)) {
+                cout << "\nDate: " << record.date
+                     << "\nCondition: " << record.condition
+                     << "\nSymptoms: " << record.symptoms
+                     << "\nActions: " << record.actions
+                     << "\n-----------------" << endl;
+            }
+        }
+    }
+
     returnToMainMenu();
 }
 
@@ -277,6 +481,7 @@ void deletePlant() {
     }
 
     string plantName = plants[choice-1].name;
+    dropHistory(plants[choice-1].id);
     plants.erase(plants.begin() + choice - 1);
     saveToFile();
     cout << "\n" << plantName << " has been deleted.\n";
@@ -324,7 +529,8 @@ void recordHealthCheck() {
     cin >> repot;
     plants[choice-1].needsRepotting = (repot == 'y' || repot == 'Y');
 
-    plants[choice-1].healthHistory.push_back(record);
+    getHealthHistory(plants[choice-1]).push_back(record);
+    markHistoryDirty(plants[choice-1]);
     saveToFile();
     cout << "\nHealth record added!\n";
 
@@ -518,68 +724,320 @@ void displayPlant(const Plant& plant) {
 // File I/O
 
 void saveToFile() {
-    ofstream file("plants.txt");
-    if (file.is_open()) {
-        for (const Plant& plant : plants) {
-            file << "PLANT\n";
-            file << plant.name << "\n";
-            file << plant.species << "\n";
-            file << plant.location << "\n";
-            file << plant.wateringFrequency << "\n";
-            file << plant.lastWatered << "\n";
-            file << plant.lastFertilized << "\n";
-            file << plant.soilType << "\n";
-            file << plant.potSize << "\n";
-            file << plant.needsRepotting << "\n";
-            file << plant.nextWateringDate << "\n";
-
-            file << "HEALTH_RECORDS\n";
-            for (const HealthRecord& record : plant.healthHistory) {
-                file << record.date << "\n";
-                file << record.condition << "\n";
-                file << record.symptoms << "\n";
-                file << record.actions << "\n";
+    // Histories that are not cached are copied straight from the old file
+    // (or plants.spill), so the new file is written next to it and swapped in at the end
+    ifstream oldFile("plants.txt", ios::binary);
+    ifstream spillFile("plants.spill", ios::binary);
+    ofstream file("plants.tmp", ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open plants.tmp");
+    }
+
+    vector<streampos> offsets;
+    vector<int> counts;
+    for (const Plant& plant : plants) {
+        writePlantHeader(file, plant);
+
+        file << "HEALTH_RECORDS\n";
+        offsets.push_back(file.tellp());
+
+        auto cached = historyCache.find(plant.id);
+        if (cached != historyCache.end()) {
+            writeHealthRecords(file, cached->second.records);
+            counts.push_back(cached->second.records.size());
+        } else {
+            writeHealthRecords(file, readHealthRecords(plant.historySpilled ? spillFile : oldFile, plant));
+            counts.push_back(plant.historyCount);
+        }
+        file << "END_HEALTH_RECORDS\n";
+
+        if (!plant.healthSummaries.empty()) {
+            file << "HEALTH_SUMMARIES\n";
+            for (const HealthSummary& summary : plant.healthSummaries) {
+                file << summary.month << "\n";
+                file << summary.firstDate << "\n";
+                file << summary.lastDate << "\n";
+                file << summary.conditionCounts.size() << "\n";
+                for (const auto& count : summary.conditionCounts) {
+                    file << count.first << "\n";
+                    file << count.second << "\n";
+                }
             }
-            file << "END_HEALTH_RECORDS\n";
+            file << "END_HEALTH_SUMMARIES\n";
         }
-        file.close();
+        if (!plant.coldSegments.empty()) {
+            file << "COLD_SEGMENTS\n";
+            for (streamoff offset : plant.coldSegments) {
+                file << offset << "\n";
+            }
+            file << "END_COLD_SEGMENTS\n";
+        }
+    }
+    oldFile.close();
+    spillFile.close();
+    file.close();
+
+    // Never replace a good plants.txt with a short write
+    if (!file) {
+        remove("plants.tmp");
+        throw runtime_error("Could not write plants.tmp");
+    }
+    // --remind may have plants.txt open for a moment while it reloads, so retry briefly
+    bool replaced = false;
+    for (int attempt = 0; attempt < 20; attempt++) {
+        if (MoveFileExA("plants.tmp", "plants.txt", MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            replaced = true;
+            break;
+        }
+        DWORD error = GetLastError();
+        if (error != ERROR_SHARING_VIOLATION && error != ERROR_ACCESS_DENIED) break;
+        Sleep(50);
+    }
+    if (!replaced) {
+        throw runtime_error("Could not save plants.txt");
+    }
+
+    for (size_t i = 0; i < plants.size(); i++) {
+        plants[i].historyOffset = offsets[i];
+        plants[i].historyCount = counts[i];
+        plants[i].historySpilled = false;
     }
+    remove("plants.spill");
+    for (auto& entry : historyCache) {
+        entry.second.dirty = false;
+    }
+
+    writeCheckpoint();
+}
+
+void writePlantHeader(ostream& file, const Plant& plant) {
+    file << "PLANT\n";
+    file << plant.name << "\n";
+    file << plant.species << "\n";
+    file << plant.location << "\n";
+    file << plant.wateringFrequency << "\n";
+    file << plant.lastWatered << "\n";
+    file << plant.lastFertilized << "\n";
+    file << plant.soilType << "\n";
+    file << plant.potSize << "\n";
+    file << plant.needsRepotting << "\n";
+    file << plant.nextWateringDate << "\n";
 }
 
 void loadFromFile() {
-    ifstream file("plants.txt");
+    vector<Plant> loaded = readPlantFile("plants.txt");
+    plants.insert(plants.end(), loaded.begin(), loaded.end());
+}
+
+vector<Plant> readPlantFile(const string& path) {
+    vector<Plant> loaded;
+    ifstream file(path, ios::binary);
     if (file.is_open()) {
         string line;
-        while (getline(file, line)) {
+        while (readLine(file, line)) {
             if (line == "PLANT") {
                 Plant plant;
-                getline(file, plant.name);
-                getline(file, plant.species);
-                getline(file, plant.location);
-                getline(file, plant.wateringFrequency);
-                getline(file, plant.lastWatered);
-                getline(file, plant.lastFertilized);
-                getline(file, plant.soilType);
-                getline(file, plant.potSize);
+                plant.id = nextPlantId++;
+                readLine(file, plant.name);
+                readLine(file, plant.species);
+                readLine(file, plant.location);
+                readLine(file, plant.wateringFrequency);
+                readLine(file, plant.lastWatered);
+                readLine(file, plant.lastFertilized);
+                readLine(file, plant.soilType);
+                readLine(file, plant.potSize);
                 string repotting;
-                getline(file, repotting);
+                readLine(file, repotting);
                 plant.needsRepotting = (repotting == "1");
-                getline(file, plant.nextWateringDate);
-
-                getline(file, line); // HEALTH_RECORDS
-                while (getline(file, line) && line != "END_HEALTH_RECORDS") {
-                    HealthRecord record;
-                    record.date = line;
-                    getline(file, record.condition);
-                    getline(file, record.symptoms);
-                    getline(file, record.actions);
-                    plant.healthHistory.push_back(record);
+                readLine(file, plant.nextWateringDate);
+
+                // Only remember where the records are; they are read on first access
+                readLine(file, line); // HEALTH_RECORDS
+                plant.historyOffset = file.tellg();
+                plant.historyCount = 0;
+                plant.historySpilled = false;
+                while (readLine(file, line) && line != "END_HEALTH_RECORDS") {
+                    for (int i = 0; i < 3; i++) {
+                        readLine(file, line);
+                    }
+                    plant.historyCount++;
+                }
+                loaded.push_back(plant);
+            } else if (line == "HEALTH_SUMMARIES" && !loaded.empty()) {
+                while (readLine(file, line) && line != "END_HEALTH_SUMMARIES") {
+                    HealthSummary summary;
+                    summary.month = line;
+                    readLine(file, summary.firstDate);
+                    readLine(file, summary.lastDate);
+                    readLine(file, line);
+                    long long kinds = parseStoredNumber(line, path);
+                    for (long long i = 0; i < kinds; i++) {
+                        string condition;
+                        if (!readLine(file, condition) || !readLine(file, line)) {
+                            throw runtime_error(path + " is corrupted");
+                        }
+                        summary.conditionCounts[condition] = parseStoredNumber(line, path);
+                    }
+                    loaded.back().healthSummaries.push_back(summary);
+                }
+            } else if (line == "COLD_SEGMENTS" && !loaded.empty()) {
+                while (readLine(file, line) && line != "END_COLD_SEGMENTS") {
+                    loaded.back().coldSegments.push_back(parseStoredNumber(line, path));
                 }
-                plants.push_back(plant);
             }
         }
         file.close();
     }
+    return loaded;
+}
+
+void writeHealthRecords(ostream& file, const vector<HealthRecord>& records) {
+    for (const HealthRecord& record : records) {
+        file << record.date << "\n";
+        file << record.condition << "\n";
+        file << record.symptoms << "\n";
+        file << record.actions << "\n";
+    }
+}
+
+// Size of the file in bytes, 0 if it does not exist
+streamoff fileSize(const string& path) {
+    ifstream file(path, ios::binary | ios::ate);
+    return file.is_open() ? streamoff(file.tellg()) : 0;
+}
+
+// Counts and offsets written by saveToFile; anything else means the file was damaged
+long long parseStoredNumber(const string& text, const string& path) {
+    if (text.empty() || text.size() > 18 || text.find_first_not_of("0123456789") != string::npos) {
+        throw runtime_error(path + " is corrupted");
+    }
+    return stoll(text);
+}
+
+bool readLine(istream& in, string& line) {
+    if (!getline(in, line)) return false;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
+
+vector<HealthRecord> readHealthRecords(istream& in, const Plant& plant) {
+    vector<HealthRecord> records;
+    if (plant.historyOffset == streampos(-1) || plant.historyCount == 0) {
+        return records;
+    }
+
+    in.clear();
+    in.seekg(plant.historyOffset);
+    for (int i = 0; i < plant.historyCount; i++) {
+        HealthRecord record;
+        readLine(in, record.date);
+        readLine(in, record.condition);
+        readLine(in, record.symptoms);
+        readLine(in, record.actions);
+        records.push_back(record);
+    }
+    if (!in) {
+        throw runtime_error("Health records for " + plant.name + " could not be read");
+    }
+    return records;
+}
+
+// Only one process may change plants.txt at a time: the menu keeps offsets
+// into the file that --compact would invalidate. Windows deletes the lock
+// file once the handle is closed, even if the program crashes.
+HANDLE acquireDataLock() {
+    return CreateFileA("plants.lock", GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_ALWAYS,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+}
+
+
+// History cache
+
+vector<HealthRecord>& getHealthHistory(Plant& plant) {
+    auto cached = historyCache.find(plant.id);
+    if (cached != historyCache.end()) {
+        historyLru.splice(historyLru.begin(), historyLru, cached->second.lruPosition);
+        return cached->second.records;
+    }
+
+    ifstream file(plant.historySpilled ? "plants.spill" : "plants.txt", ios::binary);
+    HistoryCacheEntry entry;
+    entry.records = readHealthRecords(file, plant);
+    entry.bytes = estimateHistoryBytes(entry.records);
+    entry.dirty = false;
+    historyLru.push_front(plant.id);
+    entry.lruPosition = historyLru.begin();
+    historyCache[plant.id] = entry;
+    historyCacheBytes += entry.bytes;
+
+    trimHistoryCache(plant.id);
+    return historyCache[plant.id].records;
+}
+
+void markHistoryDirty(const Plant& plant) {
+    auto cached = historyCache.find(plant.id);
+    if (cached != historyCache.end()) {
+        cached->second.dirty = true;
+        historyCacheBytes -= cached->second.bytes;
+        cached->second.bytes = estimateHistoryBytes(cached->second.records);
+        historyCacheBytes += cached->second.bytes;
+        trimHistoryCache(plant.id);
+    }
+}
+
+void dropHistory(int plantId) {
+    auto cached = historyCache.find(plantId);
+    if (cached != historyCache.end()) {
+        historyCacheBytes -= cached->second.bytes;
+        historyLru.erase(cached->second.lruPosition);
+        historyCache.erase(cached);
+    }
+}
+
+// Evicts least recently used histories until the cache fits its limit. The
+// history in keepId is in use by the caller and is never evicted, so one
+// history bigger than the whole limit can still be opened.
+void trimHistoryCache(int keepId) {
+    if (historyCacheLimit == 0) return;
+
+    while (historyCacheBytes > historyCacheLimit && historyLru.back() != keepId) {
+        int victim = historyLru.back();
+        if (historyCache[victim].dirty) {
+            spillHistory(victim);
+        }
+        dropHistory(victim);
+    }
+}
+
+// Appends an evicted dirty history to plants.spill instead of rewriting
+// plants.txt; the next saveToFile folds it back in and removes the spill file
+void spillHistory(int plantId) {
+    for (Plant& plant : plants) {
+        if (plant.id != plantId) continue;
+
+        const vector<HealthRecord>& records = historyCache[plantId].records;
+        streamoff offset = fileSize("plants.spill");
+        ofstream spill("plants.spill", ios::binary | ios::app);
+        writeHealthRecords(spill, records);
+        spill.close();
+        if (!spill) {
+            throw runtime_error("Could not write plants.spill");
+        }
+
+        plant.historyOffset = offset;
+        plant.historyCount = records.size();
+        plant.historySpilled = true;
+        return;
+    }
+}
+
+size_t estimateHistoryBytes(const vector<HealthRecord>& records) {
+    size_t bytes = records.capacity() * sizeof(HealthRecord);
+    for (const HealthRecord& record : records) {
+        bytes += record.date.capacity() + record.condition.capacity()
+               + record.symptoms.capacity() + record.actions.capacity();
+    }
+    return bytes;
 }
 
 void returnToMainMenu() {
@@ -602,26 +1060,27 @@ string getCurrentDate() {
 }
 
 string calculateNextWateringDate(const string& frequency, const string& lastWatered) {
-    tm date = {};
-    stringstream ss(lastWatered);
-    string token;
-    getline(ss, token, '-');
-    date.tm_year = stoi(token) - 1900;
-    getline(ss, token, '-');
-    date.tm_mon = stoi(token) - 1;
-    getline(ss, token, '-');
-    date.tm_mday = stoi(token);
-
+    int days = 0;
     if (frequency == "Daily") {
-        date.tm_mday += 1;
+        days = 1;
     } else if (frequency == "Weekly") {
-        date.tm_mday += 7;
+        days = 7;
     } else if (frequency == "Bi-weekly") {
-        date.tm_mday += 14;
+        days = 14;
     }
 
-    time_t next = mktime(&date);
-    tm* nextDate = localtime(&next);
+    return addDays(lastWatered, days);
+}
+
+string addDays(const string& date, int days) {
+    tm shifted = parseDate(date);
+    shifted.tm_mday += days;
+
+    time_t next = mktime(&shifted);
+    tm* nextDate = (next == -1) ? NULL : localtime(&next);
+    if (nextDate == NULL) {
+        throw runtime_error("Date out of range: " + date);
+    }
 
     stringstream result;
     result << setfill('0')
@@ -632,13 +1091,55 @@ string calculateNextWateringDate(const string& frequency, const string& lastWate
     return result.str();
 }
 
+tm parseDate(const string& date) {
+    tm result = {};
+    stringstream ss(date);
+    string token;
+    getline(ss, token, '-');
+    result.tm_year = stoi(token) - 1900;
+    getline(ss, token, '-');
+    result.tm_mon = stoi(token) - 1;
+    getline(ss, token, '-');
+    result.tm_mday = stoi(token);
+    return result;
+}
+
+// Local midnight at the start of the given date
+time_t dateToTime(const string& date) {
+    tm midnight = parseDate(date);
+    midnight.tm_isdst = -1;
+    return mktime(&midnight);
+}
+
+// Returns the date as YYYY-MM-DD, or throws if it is not a real calendar date
+string normalizeDate(const string& date) {
+    if (date.find_first_not_of("0123456789-") != string::npos || count(date.begin(), date.end(), '-') != 2) {
+        throw invalid_argument("Invalid date: " + date);
+    }
+
+    tm parsed = parseDate(date);
+    tm checked = parsed;
+    checked.tm_isdst = -1;
+    if (mktime(&checked) == -1 || checked.tm_year != parsed.tm_year
+        || checked.tm_mon != parsed.tm_mon || checked.tm_mday != parsed.tm_mday) {
+        throw invalid_argument("Invalid date: " + date);
+    }
+    return addDays(date, 0);
+}
+
 void pauseProgram(int time) {
     Sleep(time);
     system("cls");
 }
 
 void mainMenu() {
-    loadFromFile();
+    try {
+        loadFromFile();
+    } catch (const exception& e) {
+        // Saving over a file we could not read would lose it, so stop here
+        printBoxedText(string("Error: ") + e.what(), RED + BOLD);
+        return;
+    }
 
     while (true) {
         clearScreen();
@@ -744,3 +1245,485 @@ void printDivider() {
 void clearScreen() {
     system("cls");
 }
+
+void printUsage() {
+    cerr << "Usage: PlantCare [--cache-size KB]\n"
+         << "       PlantCare --remind [--out FILE]\n"
+         << "       PlantCare --compact DAYS [--cache-size KB]   (while the menu is closed)\n"
+         << "       PlantCare --as-of YYYY-MM-DD\n"
+         << "       PlantCare --bench\n\n"
+         << "  --cache-size KB  keep about KB kilobytes of health records in memory (0 = no limit).\n"
+         << "                   Plant details are always loaded and are not counted, and a plant\n"
+         << "                   whose own history is larger than the limit is still opened.\n";
+}
+
+// Accepts only plain non-negative whole numbers
+bool parseCount(const string& text, size_t& value) {
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    value = stoul(text);
+    return true;
+}
+
+
+// Reminder mode
+
+int runReminders(const string& outputPath) {
+    ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath, ios::app);
+        if (!outputFile.is_open()) {
+            cerr << "Could not open " << outputPath << " for reminders\n";
+            return 1;
+        }
+    }
+    ostream& out = outputPath.empty() ? cout : outputFile;
+
+    // Wakes us whenever the menu program rewrites plants.txt
+    HANDLE change = FindFirstChangeNotificationA(".", FALSE,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (change == INVALID_HANDLE_VALUE) {
+        cerr << "Could not watch plants.txt for changes\n";
+        return 1;
+    }
+
+    // Only a new write time on plants.txt itself means the plants changed
+    FILETIME loadedWriteTime = {};
+    try {
+        getLastWriteTime("plants.txt", loadedWriteTime);
+        loadFromFile();
+    } catch (const exception& e) {
+        cerr << "Error: could not load plants.txt: " << e.what() << "\n";
+    }
+    set<string> notified;
+
+    while (true) {
+        DWORD timeout = INFINITE;
+        try {
+            timeout = sendDueReminders(out, notified);
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << "\n";
+        }
+
+        DWORD result = WaitForSingleObject(change, timeout);
+        if (result == WAIT_FAILED) {
+            cerr << "Waiting for reminders failed\n";
+            break;
+        }
+        if (result == WAIT_OBJECT_0) {
+            FindNextChangeNotification(change);
+
+            // The menu's plants.tmp and other files in the folder wake us too. Skip
+            // those, and keep what we have if plants.txt was removed.
+            FILETIME writeTime;
+            if (!getLastWriteTime("plants.txt", writeTime)
+                || CompareFileTime(&writeTime, &loadedWriteTime) == 0) {
+                continue;
+            }
+            loadedWriteTime = writeTime;
+
+            try {
+                vector<Plant> loaded = readPlantFile("plants.txt");
+                plants = loaded;
+                historyCache.clear();
+                historyLru.clear();
+                historyCacheBytes = 0;
+            } catch (const exception& e) {
+                cerr << "Error: could not reload plants.txt: " << e.what() << "\n";
+            }
+        }
+    }
+
+    FindCloseChangeNotification(change);
+    return 1;
+}
+
+// Reads the write time without opening the file, so the menu can still replace it
+bool getLastWriteTime(const string& path, FILETIME& writeTime) {
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes)) {
+        return false;
+    }
+    writeTime = attributes.ftLastWriteTime;
+    return true;
+}
+
+// Reports plants that became due and returns how long to sleep until the
+// next one does. A plant is reported once per due date; its key is its name,
+// due date and how many earlier plants share both, so two plants with the
+// same name are still told apart.
+DWORD sendDueReminders(ostream& out, set<string>& notified) {
+    string today = getCurrentDate();
+    string earliest;
+    vector<pair<const Plant*, string>> due;
+    set<string> current;
+    map<string, int> seen;
+
+    for (const Plant& plant : plants) {
+        string dueDate;
+        try {
+            dueDate = normalizeDate(plant.nextWateringDate);
+        } catch (const exception&) {
+            cerr << "Skipping " << plant.name << ": invalid next watering date \""
+                 << plant.nextWateringDate << "\"\n";
+            continue;
+        }
+
+        string base = plant.name + "|" + dueDate;
+        string key = base + "|" + to_string(seen[base]++);
+        current.insert(key);
+        if (notified.count(key)) continue;
+
+        if (dueDate <= today) {
+            due.push_back(make_pair(&plant, key));
+        } else if (earliest.empty() || dueDate < earliest) {
+            earliest = dueDate;
+        }
+    }
+
+    if (!due.empty()) {
+        out << "[" << today << "] " << due.size() << " plant(s) due for watering:\n";
+        for (const auto& entry : due) {
+            const Plant* plant = entry.first;
+            out << "  - " << plant->name << " (due " << plant->nextWateringDate
+                << ", last watered " << plant->lastWatered << ")\n";
+            notified.insert(entry.second);
+        }
+        out.flush();
+    }
+
+    // Forget plants that were watered, renamed or deleted since we reported them
+    for (auto it = notified.begin(); it != notified.end();) {
+        it = current.count(*it) ? next(it) : notified.erase(it);
+    }
+
+    if (earliest.empty()) return INFINITE;
+
+    double seconds = difftime(dateToTime(earliest), time(0));
+    if (seconds <= 0) return 0;
+    if (seconds * 1000 < INFINITE - 1) return (DWORD)(seconds * 1000);
+    return INFINITE - 1;
+}
+
+
+// Health history compaction
+
+void compactHealthHistory(int retentionDays) {
+    // mktime cannot go back past 1970 on Windows
+    long maxDays = (long)(difftime(dateToTime(getCurrentDate()), dateToTime("1970-01-02")) / 86400);
+    if (retentionDays > maxDays) {
+        throw runtime_error("DAYS must be at most " + to_string(maxDays));
+    }
+    string cutoff = addDays(getCurrentDate(), -retentionDays);
+
+    // Blocks are only ever appended, so their offsets stay valid
+    streamoff coldSize = fileSize("plants.cold");
+    ofstream cold("plants.cold", ios::binary | ios::app);
+    if (!cold.is_open()) {
+        throw runtime_error("Could not open plants.cold");
+    }
+
+    int compacted = 0;
+    for (Plant& plant : plants) {
+        vector<HealthRecord>& history = getHealthHistory(plant);
+        vector<HealthRecord> recent, old;
+        for (const HealthRecord& record : history) {
+            (record.date < cutoff ? old : recent).push_back(record);
+        }
+        if (old.empty()) continue;
+
+        string block = encodeColdBlock(old);
+        cold << block;
+        cold.flush();
+        if (!cold) {
+            throw runtime_error("Could not write plants.cold");
+        }
+        plant.coldSegments.push_back(coldSize);
+        coldSize += block.size();
+
+        for (const HealthRecord& record : old) {
+            addToSummary(plant, record);
+        }
+        history = recent;
+        markHistoryDirty(plant);
+        compacted += old.size();
+    }
+    cold.close();
+
+    saveToFile();
+    cout << "Compacted " << compacted << " health record(s) older than " << cutoff << ".\n";
+}
+
+void addToSummary(Plant& plant, const HealthRecord& record) {
+    string month = record.date.substr(0, 7);
+    auto it = plant.healthSummaries.begin();
+    while (it != plant.healthSummaries.end() && it->month < month) {
+        it++;
+    }
+    if (it == plant.healthSummaries.end() || it->month != month) {
+        HealthSummary summary;
+        summary.month = month;
+        summary.firstDate = record.date;
+        summary.lastDate = record.date;
+        it = plant.healthSummaries.insert(it, summary);
+    }
+
+    it->firstDate = min(it->firstDate, record.date);
+    it->lastDate = max(it->lastDate, record.date);
+    it->conditionCounts[record.condition]++;
+}
+
+// A cold block stores each distinct string once and each date as the
+// number of days since the previous record
+string encodeColdBlock(const vector<HealthRecord>& records) {
+    vector<string> dictionary;
+    map<string, int> index;
+    auto lookup = [&](const string& text) {
+        auto found = index.find(text);
+        if (found != index.end()) return found->second;
+        dictionary.push_back(text);
+        return index[text] = dictionary.size() - 1;
+    };
+
+    stringstream body;
+    string previous = records.front().date;
+    for (const HealthRecord& record : records) {
+        long days = lround(difftime(dateToTime(record.date), dateToTime(previous)) / 86400);
+        body << days << " " << lookup(record.condition) << " "
+             << lookup(record.symptoms) << " " << lookup(record.actions) << "\n";
+        previous = record.date;
+    }
+
+    stringstream block;
+    block << "COLD_BLOCK\n" << records.size() << "\n" << records.front().date << "\n"
+          << dictionary.size() << "\n";
+    for (const string& text : dictionary) {
+        block << text << "\n";
+    }
+    block << body.str() << "END_COLD_BLOCK\n";
+    return block.str();
+}
+
+vector<HealthRecord> readColdRecords(const Plant& plant) {
+    vector<HealthRecord> records;
+    ifstream cold("plants.cold", ios::binary);
+    if (!cold.is_open()) {
+        throw runtime_error("plants.cold is missing");
+    }
+
+    for (streamoff offset : plant.coldSegments) {
+        cold.clear();
+        cold.seekg(offset);
+
+        string line;
+        readLine(cold, line);
+        if (line != "COLD_BLOCK") {
+            throw runtime_error("plants.cold is corrupted");
+        }
+        readLine(cold, line);
+        int count = stoi(line);
+        string date;
+        readLine(cold, date);
+        readLine(cold, line);
+        vector<string> dictionary(stoi(line));
+        for (string& text : dictionary) {
+            readLine(cold, text);
+        }
+
+        for (int i = 0; i < count; i++) {
+            readLine(cold, line);
+            stringstream fields(line);
+            size_t condition, symptoms, actions;
+            long delta;
+            fields >> delta >> condition >> symptoms >> actions;
+            if (!fields || condition >= dictionary.size() || symptoms >= dictionary.size()
+                || actions >= dictionary.size()) {
+                throw runtime_error("plants.cold is corrupted");
+            }
+            date = addDays(date, delta);
+
+            HealthRecord record;
+            record.date = date;
+            record.condition = dictionary[condition];
+            record.symptoms = dictionary[symptoms];
+            record.actions = dictionary[actions];
+            records.push_back(record);
+        }
+    }
+    return records;
+}
+
+
+// Checkpoints
+
+// Copies today's plant details to checkpoints/YYYY-MM-DD.txt for --as-of.
+// Later saves on the same day replace it, so it holds the day's last state.
+void writeCheckpoint() {
+    CreateDirectoryA("checkpoints", NULL);
+    string path = "checkpoints/" + getCurrentDate() + ".txt";
+    string tempPath = "checkpoints/" + getCurrentDate() + ".tmp";
+
+    ofstream file(tempPath, ios::binary);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open " + tempPath);
+    }
+    for (const Plant& plant : plants) {
+        writePlantHeader(file, plant);
+        file << "HEALTH_RECORDS\n";
+        file << "END_HEALTH_RECORDS\n";
+    }
+    file.close();
+
+    if (!file || !MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        remove(tempPath.c_str());
+        throw runtime_error("Could not write " + path);
+    }
+    pruneCheckpoints();
+}
+
+// Keeps every checkpoint from the last CHECKPOINT_DAILY_DAYS days and the
+// last one of each older month, so --as-of stays exact for recent dates and
+// month-end accurate for older ones without the folder growing every day
+void pruneCheckpoints() {
+    string dailyFrom = addDays(getCurrentDate(), -CHECKPOINT_DAILY_DAYS);
+    map<string, string> lastOfMonth;
+    vector<string> checkpoints = listCheckpoints();
+    for (const string& date : checkpoints) {
+        string& last = lastOfMonth[date.substr(0, 7)];
+        last = max(last, date);
+    }
+
+    for (const string& date : checkpoints) {
+        if (date < dailyFrom && lastOfMonth[date.substr(0, 7)] != date) {
+            remove(("checkpoints/" + date + ".txt").c_str());
+        }
+    }
+}
+
+// Dates of all checkpoints on disk
+vector<string> listCheckpoints() {
+    vector<string> dates;
+    WIN32_FIND_DATAA found;
+    HANDLE search = FindFirstFileA("checkpoints\\*.txt", &found);
+    if (search == INVALID_HANDLE_VALUE) return dates;
+
+    do {
+        string name = found.cFileName;
+        if (name.size() == 14) {  // YYYY-MM-DD.txt
+            dates.push_back(name.substr(0, 10));
+        }
+    } while (FindNextFileA(search, &found));
+    FindClose(search);
+    return dates;
+}
+
+// Finds the latest checkpoint written on or before the given date
+string findCheckpoint(const string& date) {
+    string best;
+    for (const string& checkpointDate : listCheckpoints()) {
+        if (checkpointDate <= date && checkpointDate > best) {
+            best = checkpointDate;
+        }
+    }
+    return best;
+}
+
+bool printReportAsOf(const string& requestedDate) {
+    string date;
+    try {
+        date = normalizeDate(requestedDate);
+    } catch (const exception&) {
+        cerr << "Invalid date \"" << requestedDate << "\", expected YYYY-MM-DD.\n";
+        return false;
+    }
+
+    vector<Plant> shown;
+    string source;
+    try {
+        if (date >= getCurrentDate()) {
+            shown = readPlantFile("plants.txt");
+            source = "current plants.txt";
+        } else {
+            string checkpoint = findCheckpoint(date);
+            if (checkpoint.empty()) {
+                cout << "No checkpoint exists on or before " << date << ".\n";
+                return true;
+            }
+            shown = readPlantFile("checkpoints/" + checkpoint + ".txt");
+            source = "checkpoint " + checkpoint;
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
+
+    cout << "=== Plants as of " << date << " (" << source << ") ===\n";
+    int dueCount = 0;
+    for (const Plant& plant : shown) {
+        bool due = plant.nextWateringDate <= date;
+        if (due) dueCount++;
+        cout << "\n" << plant.name << " (" << plant.species << ", " << plant.location << ")\n"
+             << "  Last watered: " << plant.lastWatered
+             << "\n  Next watering: " << plant.nextWateringDate << (due ? " (DUE)" : "")
+             << "\n  Needs repotting: " << (plant.needsRepotting ? "Yes" : "No") << "\n";
+    }
+    cout << "\n" << dueCount << " of " << shown.size() << " plant(s) due for watering.\n";
+    return true;
+}
+
+
+// Benchmark
+
+// Times health history lookups against the current plants.txt at several
+// cache sizes. Two thirds of lookups go to the first tenth of the plants,
+// the way a few favourites get checked more often than the rest.
+int runBenchmark() {
+    loadFromFile();
+    if (plants.empty()) {
+        cout << "plants.txt has no plants to benchmark.\n";
+        return 1;
+    }
+
+    const int LOOKUPS = 2000;
+    const size_t sizes[] = {0, 256, 64, 16, 4};
+    size_t favourites = max(plants.size() / 10, (size_t)1);
+
+    cout << plants.size() << " plants, " << LOOKUPS << " history lookups per run\n\n";
+    cout << left << setw(14) << "Cache (KB)" << setw(14) << "Time (ms)"
+         << setw(14) << "Misses" << "Peak cached (KB)\n";
+    for (size_t kilobytes : sizes) {
+        historyCache.clear();
+        historyLru.clear();
+        historyCacheBytes = 0;
+        historyCacheLimit = kilobytes * 1024;
+        srand(1);
+
+        int misses = 0;
+        size_t peak = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            size_t index = (rand() % 3 != 0) ? rand() % favourites : rand() % plants.size();
+            if (!historyCache.count(plants[index].id)) misses++;
+            getHealthHistory(plants[index]);
+            peak = max(peak, historyCacheBytes);
+        }
+        double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << setw(14) << (kilobytes == 0 ? string("no limit") : to_string(kilobytes))
+             << setw(14) << fixed << setprecision(2) << elapsed
+             << setw(14) << misses << peak / 1024 << "\n";
+    }
+
+    // Each checkpoint is one stored version of every plant's details
+    vector<string> checkpoints = listCheckpoints();
+    if (!checkpoints.empty()) {
+        streamoff total = 0;
+        for (const string& date : checkpoints) {
+            total += fileSize("checkpoints/" + date + ".txt");
+        }
+        cout << "\n" << checkpoints.size() << " checkpoint(s), "
+             << total / (streamoff)checkpoints.size() << " bytes per version on average\n";
+    }
+    return 0;
+}